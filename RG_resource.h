@@ -6,6 +6,7 @@
 
 #include "RG_resource_base.h"
 #include "RG_resource_realize.h"
+#include "RG_resource_size.h"
 
 namespace RG {
 	class RG_renderpass_base;
@@ -39,6 +40,10 @@ namespace RG {
 			return std::holds_alternative<std::unique_ptr<actual_type_>>(actual_type) ?
 				std::get<std::unique_ptr<actual_type_>>(actual_type).get() : std::get<actual_type_*>(actual_type);
 		}
+
+		std::size_t size() const override {
+			return RG::size<description_type_>(description_type);
+		}
 	protected:
 		void realize() override {
 			if(transient())
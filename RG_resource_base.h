@@ -37,6 +37,8 @@ namespace RG {
 			return creator_ != nullptr;
 		}
 
+		virtual std::size_t size() const = 0; // ԴС
+
 	protected:
 		friend RenderGraph;
 		friend RG_renderpass_builder;
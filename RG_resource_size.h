@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+namespace RG {
+	/// <summary>
+	/// ԴռõԴСδػʱΪ 0ԴԤ㣩
+	///  realize ͬȱػ뱨ҪԤӦػ
+	/// </summary>
+	/// <typeparam name="description_type">Դ</typeparam>
+	/// <returns></returns>
+	template<typename description_type>
+	std::size_t size(const description_type&) {
+		return 0;
+	}
+}
\ No newline at end of file
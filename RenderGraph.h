@@ -8,6 +8,9 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include "RG_resource.h"
 #include "RG_renderpass.h"
@@ -22,6 +25,14 @@ namespace RG {
 		RenderGraph() = default;
 		virtual ~RenderGraph() = default;
 
+		struct budget_violation // ԴԤʱ䲽̬Դ
+		{
+			std::size_t step;
+			const RG_renderpass_base* render_pass;
+			std::size_t live_size;
+			std::vector<const RG_resource_base*> live_resources;
+		};
+
 		/// <summary>
 		///  RG  render pass
 		/// </summary>
@@ -56,7 +67,8 @@ namespace RG {
 		/// <summary>
 		/// 
 		/// </summary>
-		void compile() {
+		/// <param name="memory_budget">̬ԴԴԤ㣬0 ʾƣδػ RG::size Դ 0 </param>
+		void compile(const std::size_t memory_budget = 0) {
 			// 
 			for (auto& render_pass : render_passes_)
 				render_pass->ref_count_ = render_pass->creates_.size() + render_pass->writes_.size();
@@ -104,61 +116,50 @@ namespace RG {
 				}
 			}
 
-			// ʱ
-			timeline_.clear();
+			// ռδ޳Ⱦ
+			std::vector<RG_renderpass_base*> render_passes;
 			for (auto& render_pass : render_passes_) {
 				if (render_pass->ref_count_ == 0 && !render_pass->cull())
 					continue;
+				render_passes.push_back(render_pass.get());
+			}
 
-				std::vector<RG_resource_base*> realized_resources, derealized_resources;
-				for (auto resource : render_pass->creates_) {
-					realized_resources.push_back(const_cast<RG_resource_base*>(resource));
-					if (resource->readers_.empty() && resource->writers_.empty())
-						derealized_resources.push_back(const_cast<RG_resource_base*>(resource));
-				}
-
-				auto reads_writes = render_pass->reads_;
-				reads_writes.insert(reads_writes.end(), render_pass->writes_.begin(), render_pass->writes_.end());
-				for (auto resource : reads_writes) {
-					if (!resource->transient())
-						continue;
-
-					// ҵԴĶд
-					auto valid = false;
-					std::size_t last_index;
-					if (!resource->readers_.empty()) {
-						auto last_reader = std::find_if(
-							render_passes_.begin(),
-							render_passes_.end(),
-							[&resource](const std::unique_ptr<RG_renderpass_base>& reader) {
-								return reader.get() == resource->readers_.back();
-							});
-						if (last_reader != render_passes_.end()) {
-							valid = true;
-							last_index = std::distance(render_passes_.begin(), last_reader);
-						}
-					}
+			// ʱᣬԴԤʱԴռ
+			memory_budget_ = memory_budget;
+			timeline_ = build_timeline(render_passes);
+			if (memory_budget_ > 0 && memory_peak(timeline_) > memory_budget_) {
+				auto scheduled_timeline = build_timeline(schedule(render_passes));
+				if (memory_peak(scheduled_timeline) < memory_peak(timeline_))
+					timeline_ = std::move(scheduled_timeline);
+			}
 
-					if (!resource->writers_.empty()) {
-						auto last_writer = std::find_if(
-							render_passes_.begin(),
-							render_passes_.end(),
-							[&resource](const std::unique_ptr<RG_renderpass_base>& writer) {
-								return writer.get() == resource->writers_.back();
-							});
-						if (last_writer != render_passes_.end()) {
-							valid = true;
-							last_index = std::max(last_index, std::size_t(std::distance(render_passes_.begin(), last_writer)));
-						}
-					}
+			// ¼ԴԤʱ䲽
+			budget_violations_.clear();
+			peak_memory_ = memory_peak(timeline_, memory_budget_, &budget_violations_);
+		}
 
-					if (valid && render_passes_[last_index] == render_pass)
-						derealized_resources.push_back(const_cast<RG_resource_base*>(resource));
-				}
+		/// <summary>
+		/// ԴԤ㣬0 ʾ
+		/// </summary>
+		/// <returns></returns>
+		std::size_t memory_budget() const {
+			return memory_budget_;
+		}
 
-				timeline_.push_back(step{ render_pass.get(), realized_resources, derealized_resources });
-			}
+		/// <summary>
+		/// ʱ̬ԴԴֵ
+		/// </summary>
+		/// <returns></returns>
+		std::size_t peak_memory() const {
+			return peak_memory_;
+		}
 
+		/// <summary>
+		/// ԴԤʱ䲽ΪձʾԤ
+		/// </summary>
+		/// <returns></returns>
+		const std::vector<budget_violation>& budget_violations() const {
+			return budget_violations_;
 		}
 
 		/// <summary>
@@ -180,6 +181,10 @@ namespace RG {
 		void clear() {
 			render_passes_.clear();
 			resources_.clear();
+			timeline_.clear();
+			memory_budget_ = 0;
+			peak_memory_ = 0;
+			budget_violations_.clear();
 		}
 
 		/// <summary>
@@ -232,6 +237,45 @@ namespace RG {
 			stream << "}";
 		}
 
+		/// <summary>
+		/// ԴԤ㱨棬гԤʱ䲽Դ
+		/// </summary>
+		/// <param name="filepath"></param>
+		void export_budget_report(const std::string& filepath)
+		{
+			std::ofstream stream(filepath);
+			stream << "Memory budget: " << memory_budget_ << "\n";
+			stream << "Peak memory: " << peak_memory_ << "\n";
+
+			// δػ RG::size ̬Դ 0 룬ԤΪ
+			std::vector<const RG_resource_base*> unsized_resources;
+			for (auto& timeline_step : timeline_) {
+				for (auto resource : timeline_step.realized_resources) {
+					if (resource->size() == 0)
+						unsized_resources.push_back(resource);
+				}
+			}
+			if (!unsized_resources.empty()) {
+				stream << "Unsized transient resources (counted as 0):";
+				for (auto resource : unsized_resources)
+					stream << " \"" << resource->name() << "\"";
+				stream << "\n";
+			}
+
+			if (budget_violations_.empty()) {
+				stream << "Budget satisfied\n";
+				return;
+			}
+
+			for (auto& violation : budget_violations_) {
+				stream << "\nStep " << violation.step << " \"" << violation.render_pass->name() << "\": "
+					<< violation.live_size << " / " << memory_budget_ << "\n";
+				for (auto resource : violation.live_resources)
+					stream << "\t\"" << resource->name() << "\" " << resource->size()
+						<< " (created by \"" << resource->creator_->name() << "\")\n";
+			}
+		}
+
 	protected:
 		friend RG_renderpass_builder;
 
@@ -241,10 +285,201 @@ namespace RG {
 			std::vector<RG_resource_base*> realized_resources;
 			std::vector<RG_resource_base*> derealized_resources;
 		};
+
+		/// <summary>
+		/// Ⱦ漰Դȥأsecond ʾǷ񴴽д
+		/// </summary>
+		/// <param name="render_pass"></param>
+		/// <returns></returns>
+		static std::vector<std::pair<const RG_resource_base*, bool>> resource_accesses(const RG_renderpass_base* render_pass) {
+			std::vector<std::pair<const RG_resource_base*, bool>> accesses;
+			auto add_access = [&accesses](const RG_resource_base* resource, const bool write) {
+				auto access = std::find_if(
+					accesses.begin(),
+					accesses.end(),
+					[resource](const std::pair<const RG_resource_base*, bool>& other) {
+						return other.first == resource;
+					});
+				if (access == accesses.end())
+					accesses.emplace_back(resource, write);
+				else
+					access->second = access->second || write;
+			};
+			for (auto resource : render_pass->creates_)
+				add_access(resource, true);
+			for (auto resource : render_pass->reads_)
+				add_access(resource, false);
+			for (auto resource : render_pass->writes_)
+				add_access(resource, true);
+			return accesses;
+		}
+
+		/// <summary>
+		/// ˳ʱᣬ̬Դڵһʹʱʵһʹúͷ
+		/// </summary>
+		/// <param name="render_passes"></param>
+		/// <returns></returns>
+		std::vector<step> build_timeline(const std::vector<RG_renderpass_base*>& render_passes) const {
+			std::vector<step> timeline;
+			std::unordered_map<const RG_resource_base*, std::pair<std::size_t, std::size_t>> lifetimes; // һκһʹõʱ䲽
+			for (std::size_t index = 0; index < render_passes.size(); index++) {
+				auto render_pass = render_passes[index];
+				timeline.push_back(step{ render_pass, {}, {} });
+				for (auto list : { &render_pass->creates_, &render_pass->reads_, &render_pass->writes_ }) {
+					for (auto resource : *list) {
+						if (!resource->transient())
+							continue;
+						auto lifetime = lifetimes.emplace(resource, std::make_pair(index, index)).first;
+						lifetime->second.second = index;
+					}
+				}
+			}
+
+			for (auto& resource : resources_) {
+				auto lifetime = lifetimes.find(resource.get());
+				if (lifetime == lifetimes.end())
+					continue;
+				timeline[lifetime->second.first].realized_resources.push_back(resource.get());
+				timeline[lifetime->second.second].derealized_resources.push_back(resource.get());
+			}
+			return timeline;
+		}
+
+		/// <summary>
+		/// ʱ̬ԴԴֵ violations ʱ¼Ԥʱ䲽
+		/// </summary>
+		/// <param name="timeline"></param>
+		/// <param name="memory_budget"></param>
+		/// <param name="violations"></param>
+		/// <returns></returns>
+		static std::size_t memory_peak(const std::vector<step>& timeline, const std::size_t memory_budget = 0, std::vector<budget_violation>* violations = nullptr) {
+			std::size_t live_size = 0, peak_size = 0;
+			std::vector<const RG_resource_base*> live_resources;
+			for (std::size_t index = 0; index < timeline.size(); index++) {
+				auto& step = timeline[index];
+				for (auto resource : step.realized_resources) {
+					live_size += resource->size();
+					if (violations)
+						live_resources.push_back(resource);
+				}
+
+				peak_size = std::max(peak_size, live_size);
+				if (violations && memory_budget > 0 && live_size > memory_budget)
+					violations->push_back(budget_violation{ index, step.render_pass, live_size, live_resources });
+
+				for (auto resource : step.derealized_resources) {
+					live_size -= resource->size();
+					if (violations)
+						live_resources.erase(std::find(live_resources.begin(), live_resources.end(), resource));
+				}
+			}
+			return peak_size;
+		}
+
+		/// <summary>
+		/// Դдǰ£̰ĵѡԴռ͵Ⱦ
+		/// </summary>
+		/// <param name="render_passes"></param>
+		/// <returns></returns>
+		std::vector<RG_renderpass_base*> schedule(const std::vector<RG_renderpass_base*>& render_passes) const {
+			const auto count = render_passes.size();
+			std::vector<std::vector<std::size_t>> successors(count);
+			std::vector<std::size_t> predecessors(count, 0);
+			auto add_dependency = [&](const std::size_t from, const std::size_t to) {
+				if (std::find(successors[from].begin(), successors[from].end(), to) != successors[from].end())
+					return;
+				successors[from].push_back(to);
+				predecessors[to]++;
+			};
+
+			// ԭʼ˳д֮ǰĶд֮ǰд
+			struct resource_state {
+				std::size_t last_writer; // д
+				std::vector<std::size_t> readers; // һд֮Ķȡ
+				std::size_t users; // δִеʹ
+			};
+			std::unordered_map<const RG_resource_base*, resource_state> states;
+			std::vector<std::vector<std::pair<const RG_resource_base*, bool>>> accesses(count);
+			for (std::size_t index = 0; index < count; index++) {
+				accesses[index] = resource_accesses(render_passes[index]);
+				for (auto& access : accesses[index]) {
+					auto& state = states.emplace(access.first, resource_state{ count, {}, 0 }).first->second;
+					state.users++;
+					if (state.last_writer != count)
+						add_dependency(state.last_writer, index);
+					if (access.second) {
+						for (auto reader : state.readers)
+							add_dependency(reader, index);
+						state.readers.clear();
+						state.last_writer = index;
+					}
+					else {
+						state.readers.push_back(index);
+					}
+				}
+			}
+
+			// ûԴ򲻿޳иãԭʼλ
+			for (std::size_t index = 0; index < count; index++) {
+				if (!accesses[index].empty() && !render_passes[index]->cull())
+					continue;
+				for (std::size_t other = 0; other < count; other++) {
+					if (other < index)
+						add_dependency(other, index);
+					else if (other > index)
+						add_dependency(index, other);
+				}
+			}
+
+			std::vector<RG_renderpass_base*> scheduled_passes;
+			std::vector<bool> scheduled(count, false);
+			std::unordered_set<const RG_resource_base*> realized;
+			std::size_t live_size = 0;
+			while (scheduled_passes.size() < count) {
+				// ѡִʱԴ͵ѡִкͷ󱣳ԭʼ˳
+				auto best = count;
+				std::size_t best_peak = 0, best_live = 0;
+				for (std::size_t index = 0; index < count; index++) {
+					if (scheduled[index] || predecessors[index] > 0)
+						continue;
+
+					auto peak = live_size;
+					for (auto& access : accesses[index]) {
+						if (access.first->transient() && realized.count(access.first) == 0)
+							peak += access.first->size();
+					}
+					auto live = peak;
+					for (auto& access : accesses[index]) {
+						if (access.first->transient() && states.at(access.first).users == 1)
+							live -= access.first->size();
+					}
+
+					if (best == count || peak < best_peak || (peak == best_peak && live < best_live)) {
+						best = index;
+						best_peak = peak;
+						best_live = live;
+					}
+				}
+
+				scheduled[best] = true;
+				scheduled_passes.push_back(render_passes[best]);
+				live_size = best_live;
+				for (auto& access : accesses[best]) {
+					realized.insert(access.first);
+					states.at(access.first).users--;
+				}
+				for (auto successor : successors[best])
+					predecessors[successor]--;
+			}
+			return scheduled_passes;
+		}
 		
 		std::vector<std::unique_ptr<RG_renderpass_base>> render_passes_; // еȾ
 		std::vector<std::unique_ptr<RG_resource_base>> resources_; // еԴ
 		std::vector<step> timeline_; // ʱ
+		std::size_t memory_budget_ = 0; // ԴԤ
+		std::size_t peak_memory_ = 0; // Դֵ
+		std::vector<budget_violation> budget_violations_; // ԴԤʱ䲽
 	};
 
 	template<typename resource_type, typename description_type>
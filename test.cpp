@@ -1,4 +1,7 @@
 #include <array>
+#include <cassert>
+#include <string>
+#include <vector>
 
 #include "RenderGraph.h"
 
@@ -36,12 +39,24 @@ namespace RG {
 	std::unique_ptr<resource_type::texture_2d> realize(const resource_type::texture_description& description) {
 		return std::make_unique<resource_type::buffer>(description.levels);
 	}
+
+	template<>
+	std::size_t size(const resource_type::buffer_description& description) {
+		return description.size;
+	}
+
+	template<>
+	std::size_t size(const resource_type::texture_description& description) {
+		return description.levels * description.size[0] * description.size[1] * description.size[2] * 4;
+	}
 }
 
 int main()
 {
     RG::RenderGraph rendergraph;
 
+    const resource_type::texture_description description{ 1, 0, { 1920, 1080, 1 } };
+
     auto retained_resource = rendergraph.add_retained_resource("Retained Resource 1", resource_type::texture_description(), static_cast<resource_type::texture_2d*>(nullptr));
 
     // render pass
@@ -56,9 +71,9 @@ int main()
         "Render Task 1",
         [&](render_task_1_data& data, RG::RG_renderpass_builder& builder)
         {
-            data.output1 = builder.create<resource_type::texture_2d_resource>("Resource 1", resource_type::texture_description());
-            data.output2 = builder.create<resource_type::texture_2d_resource>("Resource 2", resource_type::texture_description());
-            data.output3 = builder.create<resource_type::texture_2d_resource>("Resource 3", resource_type::texture_description());
+            data.output1 = builder.create<resource_type::texture_2d_resource>("Resource 1", description);
+            data.output2 = builder.create<resource_type::texture_2d_resource>("Resource 2", description);
+            data.output3 = builder.create<resource_type::texture_2d_resource>("Resource 3", description);
             data.output4 = builder.write <resource_type::texture_2d_resource>(retained_resource);
         },
         [=](const render_task_1_data& data)
@@ -86,7 +101,7 @@ int main()
             data.input1 = builder.read(data_1.output1);
             data.input2 = builder.read(data_1.output2);
             data.output1 = builder.write(data_1.output3);
-            data.output2 = builder.create<resource_type::texture_2d_resource>("Resource 4", resource_type::texture_description());
+            data.output2 = builder.create<resource_type::texture_2d_resource>("Resource 4", description);
         },
         [=](const render_task_2_data& data)
         {
@@ -120,11 +135,93 @@ int main()
             auto actual3 = data.output->actual();
         });
 
-    rendergraph.compile();
+    rendergraph.compile(3 * RG::size(description));
     for (auto i = 0; i < 100; i++)
         rendergraph.execute();
     rendergraph.export_graphviz("rendergraph.gv");
+    rendergraph.export_budget_report("budget_report.txt");
+    rendergraph.clear();
+
+    // independent branches: A, C, B, D keeps X and Y alive together, A, B, C, D halves the peak
+    std::vector<std::string> execution_order;
+    auto retained_resource_2 = rendergraph.add_retained_resource("Retained Resource 2", resource_type::texture_description(), static_cast<resource_type::texture_2d*>(nullptr));
+
+    struct create_task_data
+    {
+        resource_type::texture_2d_resource* output;
+    };
+    struct read_task_data
+    {
+        resource_type::texture_2d_resource* input;
+        resource_type::texture_2d_resource* output;
+    };
+    auto add_create_task = [&](const std::string& name, const std::string& resource_name)
+    {
+        return rendergraph.add_render_pass<create_task_data>(
+            name,
+            [&](create_task_data& data, RG::RG_renderpass_builder& builder)
+            {
+                data.output = builder.create<resource_type::texture_2d_resource>(resource_name, description);
+            },
+            [&execution_order, name](const create_task_data& data)
+            {
+                assert(data.output->actual());
+                execution_order.push_back(name);
+            });
+    };
+    auto add_read_task = [&](const std::string& name, resource_type::texture_2d_resource* input)
+    {
+        return rendergraph.add_render_pass<read_task_data>(
+            name,
+            [&](read_task_data& data, RG::RG_renderpass_builder& builder)
+            {
+                data.input = builder.read(input);
+                data.output = builder.write(retained_resource_2);
+            },
+            [&execution_order, name](const read_task_data& data)
+            {
+                assert(data.input->actual());
+                execution_order.push_back(name);
+            });
+    };
+
+    auto task_a = add_create_task("A", "X");
+    auto task_c = add_create_task("C", "Y");
+    add_read_task("B", task_a->data().output);
+    add_read_task("D", task_c->data().output);
+
+    // resource-less pass that must not be culled stays last
+    struct present_task_data {};
+    auto present_task = rendergraph.add_render_pass<present_task_data>(
+        "Present",
+        [&](present_task_data&, RG::RG_renderpass_builder&) {},
+        [&](const present_task_data&)
+        {
+            execution_order.push_back("Present");
+        });
+    present_task->set_cull(true);
+
+    const auto unit = RG::size(description);
+    rendergraph.compile();
+    assert(rendergraph.peak_memory() == 2 * unit);
+
+    rendergraph.compile(unit);
+    assert(rendergraph.peak_memory() == unit);
+    assert(rendergraph.budget_violations().empty());
+    rendergraph.execute();
+    assert((execution_order == std::vector<std::string>{ "A", "B", "C", "D", "Present" }));
+
+    // unreachable budget: every offending step is reported with its live resources
+    rendergraph.compile(unit / 2);
+    assert(rendergraph.peak_memory() == unit);
+    auto& violations = rendergraph.budget_violations();
+    assert(violations.size() == 4);
+    assert(violations[0].render_pass->name() == "A" && violations[0].live_size == unit);
+    assert(violations[0].live_resources.size() == 1 && violations[0].live_resources[0]->name() == "X");
+    assert(violations[3].render_pass->name() == "D" && violations[3].live_resources[0]->name() == "Y");
+    rendergraph.export_budget_report("budget_report_branches.txt");
     rendergraph.clear();
+    assert(rendergraph.peak_memory() == 0 && rendergraph.memory_budget() == 0);
 
     return 0;
 }